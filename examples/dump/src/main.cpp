@@ -59,4 +59,13 @@ int main(int argc, char *argv[]) {
 
     // Progress world, will dump iterator
     ecs.progress();
+
+    // Track changes to Position and Velocity. Both are only changed with
+    // set<T>(), so their values don't need to be hashed.
+    flecs::dump_tracker tracker(ecs);
+    tracker.track<Position>().track<Velocity>();
+
+    // Only Beethoven changed, so only Beethoven is dumped
+    e1.set<Position>({20, 30});
+    tracker.dump();
 }
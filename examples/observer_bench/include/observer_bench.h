@@ -0,0 +1,16 @@
+#ifndef OBSERVER_BENCH_H
+#define OBSERVER_BENCH_H
+
+/* This generated file contains includes for project dependencies */
+#include "observer_bench/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
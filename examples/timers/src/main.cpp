@@ -29,11 +29,25 @@ int main(int argc, char *argv[]) {
     // Delete entity after 15 seconds
     e.set<flecs::DeleteTimer>({15});
 
+    // Timers inherited from a prefab are ignored, so this entity is never
+    // deleted.
+    auto prefab = ecs.prefab("TimerPrefab")
+        .set<flecs::DeleteTimer>({5});
+
+    auto instance = ecs.entity()
+        .add_instanceof(prefab);
+
     // Run main loop at 1 FPS
     ecs.set_target_fps(1);
 
     while (ecs.progress()) { 
         // Print type of entity so we can see the effect of the timers
         std::cout << e.type().str() << std::endl;
+
+        // Check that the instance wasn't deleted by the inherited timer
+        if (!ecs_is_alive(ecs.c_ptr(), instance.id())) {
+            std::cout << "instance deleted by inherited timer" << std::endl;
+            return 1;
+        }
     }
 }
@@ -0,0 +1,16 @@
+#ifndef TIMERS_BENCH_H
+#define TIMERS_BENCH_H
+
+/* This generated file contains includes for project dependencies */
+#include "timers_bench/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
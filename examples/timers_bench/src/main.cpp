@@ -0,0 +1,74 @@
+#include <timers_bench.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Compares the scan used by the timer systems, which advances timers with a
+// SIMD kernel and only visits expired timers, with the scalar loop the timer
+// systems used before. One in EXPIRE_RATIO timers expires.
+
+#define TIMER_COUNT (1000000)
+#define FRAME_COUNT (200)
+#define EXPIRE_RATIO (1000)
+#define DELTA_TIME (0.016f)
+
+std::vector<flecs::AddTimer> create_timers(int32_t count) {
+    std::vector<flecs::AddTimer> timers(count);
+    for (int32_t i = 0; i < count; i ++) {
+        timers[i].timeout = (i % EXPIRE_RATIO) ? 1e9f : 0.5f;
+        timers[i].t = static_cast<float>(i % 7) * 0.1f;
+    }
+    return timers;
+}
+
+// The loop used by the timer systems before the SIMD scan
+template <typename Func>
+void scan_scalar(flecs::AddTimer *timers, int32_t count, float dt,
+    const Func& func)
+{
+    for (int32_t i = 0; i < count; i ++) {
+        timers[i].t += dt;
+        if (timers[i].t >= timers[i].timeout) {
+            func(i);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<flecs::AddTimer> scalar = create_timers(TIMER_COUNT);
+    std::vector<flecs::AddTimer> simd = scalar;
+    size_t scalar_expired = 0, simd_expired = 0;
+
+    auto t1 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAME_COUNT; f ++) {
+        scan_scalar(scalar.data(), TIMER_COUNT, DELTA_TIME, [&](int32_t i) {
+            scalar_expired ++;
+        });
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAME_COUNT; f ++) {
+        flecs::timers::scan(simd.data(), TIMER_COUNT, DELTA_TIME, [&](int32_t i) {
+            simd_expired ++;
+        });
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    // Both scans must produce the same timers and expire the same timers
+    bool equal = scalar_expired == simd_expired && !memcmp(scalar.data(),
+        simd.data(), TIMER_COUNT * sizeof(flecs::AddTimer));
+
+    double per_million = 1000000.0 / TIMER_COUNT / FRAME_COUNT;
+    double scalar_ms = std::chrono::duration<double, std::milli>(t2 - t1).count()
+        * per_million;
+    double simd_ms = std::chrono::duration<double, std::milli>(t3 - t2).count()
+        * per_million;
+
+    std::cout << "scalar: " << scalar_ms << " ms per 1M timers" << std::endl;
+    std::cout << "simd:   " << simd_ms << " ms per 1M timers" << std::endl;
+    std::cout << "speedup: " << scalar_ms / simd_ms << "x" << std::endl;
+    std::cout << "results equal: " << (equal ? "true" : "false") << std::endl;
+
+    return equal ? 0 : 1;
+}
@@ -2,6 +2,15 @@
 #define FLECS_DUMP_H
 
 #include <flecs.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace flecs {
 
@@ -97,6 +106,188 @@ void dump(flecs::iter it) {
             << std::endl << std::endl;
 }
 
+// Keeps track of entities that changed since the last checkpoint, so that only
+// those entities have to be dumped. Changes to the type of an entity, and
+// changes made with set<T>(), are detected by OnAdd, OnRemove and OnSet
+// systems. These only cost time for the entities that changed.
+//
+// Systems that write to a column and code that uses get_mut<T>() without
+// modified() don't trigger OnSet. To catch those, track_hashed<T>() also keeps
+// a hash of the component value for each entity, and compares it at each
+// checkpoint. This costs time for every entity with the component.
+class dump_tracker {
+public:
+    dump_tracker(flecs::world& ecs) 
+        : m_world(ecs.c_ptr()) { }
+
+    ~dump_tracker() {
+        for (auto s : m_systems) {
+            ecs_delete(m_world, s);
+        }
+    }
+
+    // Systems hold a pointer to the change list, so the tracker can't move
+    dump_tracker(const dump_tracker&) = delete;
+    dump_tracker& operator=(const dump_tracker&) = delete;
+
+    // Start tracking changes to a component that trigger OnAdd, OnRemove or
+    // OnSet.
+    template <typename T>
+    dump_tracker& track() {
+        flecs::world ecs(m_world);
+        flecs::entity comp = ecs.component<T>();
+        if (!m_tracked.insert(comp.id()).second) {
+            return *this;
+        }
+
+        std::string sig = comp.path(".", "");
+
+        // Adding or removing the component changes the type of the entity,
+        // setting it changes the component data. All of them mark the entity.
+        m_systems.push_back(track_system(ecs, sig, flecs::OnAdd));
+        m_systems.push_back(track_system(ecs, sig, flecs::OnRemove));
+        m_systems.push_back(track_system(ecs, sig, flecs::OnSet));
+
+        return *this;
+    }
+
+    // Start tracking changes to a component, including changes that don't
+    // trigger OnSet. Values are compared by their bytes, so the component must
+    // not point to data it owns.
+    template <typename T>
+    dump_tracker& track_hashed() {
+        static_assert(std::is_trivially_copyable<T>::value, 
+            "hashed component must be trivially copyable");
+
+        track<T>();
+
+        flecs::world ecs(m_world);
+        flecs::entity comp = ecs.component<T>();
+        if (!m_hashed.insert(comp.id()).second) {
+            return *this;
+        }
+
+        auto column = std::make_shared<column_hash<T>>(ecs);
+        std::unordered_set<entity_t> *changed = &m_changed;
+
+        // Hash component values, and mark entities for which the hash is
+        // different from the one in the last checkpoint.
+        auto scan_column = [column, changed](bool mark) {
+            column->query.each([&](flecs::entity e, T& value) {
+                uint64_t h = hash_value(&value, sizeof(T));
+                auto it = column->hashes.emplace(e.id(), h);
+                if (it.second || it.first->second != h) {
+                    it.first->second = h;
+                    if (mark) {
+                        changed->insert(e.id());
+                    }
+                }
+            });
+        };
+
+        // Entities that no longer have the component are dropped
+        m_systems.push_back(ecs.system<>(nullptr, comp.path(".", "").c_str())
+            .kind(flecs::OnRemove)
+            .action([column](flecs::iter it) {
+                for (auto i : it) {
+                    column->hashes.erase(it.entity(i).id());
+                }
+            }).id());
+
+        // Store current values, so they don't show up as changed
+        scan_column(false);
+        m_scans.push_back(scan_column);
+
+        return *this;
+    }
+
+    // Number of entities that changed since the last checkpoint
+    size_t count() {
+        scan();
+        return m_changed.size();
+    }
+
+    // Dump entities that changed since the last checkpoint, and checkpoint.
+    // Entities are dumped in order of id, so that dumps can be compared.
+    void dump() {
+        scan();
+
+        std::vector<entity_t> changed(m_changed.begin(), m_changed.end());
+        std::sort(changed.begin(), changed.end());
+
+        for (auto id : changed) {
+            if (ecs_is_alive(m_world, id)) {
+                flecs::dump(flecs::entity(m_world, id));
+            } else {
+                std::cout << "====================================" << std::endl; 
+                std::cout << " " << id << " (deleted)" << std::endl;
+                std::cout << "------------------------------------" 
+                    << std::endl << std::endl;
+            }
+        }
+
+        m_changed.clear();
+    }
+
+    // Forget changes without dumping them
+    void checkpoint() {
+        scan();
+        m_changed.clear();
+    }
+
+private:
+    // Hashes of the values of a tracked component, per entity
+    template <typename T>
+    struct column_hash {
+        column_hash(flecs::world& ecs)
+            : query(ecs) { }
+
+        flecs::query<T> query;
+        std::unordered_map<entity_t, uint64_t> hashes;
+    };
+
+    // FNV-1a. Padding bytes are hashed too, which can cause an entity to be
+    // reported when its value did not change. A change to the bytes of a 
+    // value is only missed when the hashes collide.
+    static uint64_t hash_value(const void *ptr, size_t size) {
+        const uint8_t *bytes = static_cast<const uint8_t*>(ptr);
+        uint64_t h = 14695981039346656037ull;
+        for (size_t i = 0; i < size; i ++) {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Compare hashes of tracked components with the last checkpoint
+    void scan() {
+        for (auto& s : m_scans) {
+            s(true);
+        }
+    }
+
+    entity_t track_system(flecs::world& ecs, const std::string& sig, 
+        flecs::entity_t kind) 
+    {
+        std::unordered_set<entity_t> *changed = &m_changed;
+
+        return ecs.system<>(nullptr, sig.c_str())
+            .kind(kind)
+            .action([changed](flecs::iter it) {
+                for (auto i : it) {
+                    changed->insert(it.entity(i).id());
+                }
+            }).id();
+    }
+
+    world_t *m_world;
+    std::unordered_set<entity_t> m_tracked;
+    std::unordered_set<entity_t> m_hashed;
+    std::unordered_set<entity_t> m_changed;
+    std::vector<entity_t> m_systems;
+    std::vector<std::function<void(bool)>> m_scans;
+};
+
 }
 
 #endif
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <string>
 
 namespace flecs {
 
@@ -15,7 +16,6 @@ using observer_func = std::function<void(flecs::entity, const T&)>;
 // Observer data that is stored in list of observers
 struct observer_data {
     void *ctx;
-    void(*invoke)(flecs::entity e, void *ptr, void *ctx);
 };
 
 // Trait that stores a list of observers
@@ -23,6 +23,28 @@ struct Observable {
     std::unordered_map<entity_t, observer_data> observers;
 };
 
+// Component added to an observed component, which stores the system that
+// dispatches updates of that component to its observers
+struct ObserverDispatch {
+    entity_t system;
+};
+
+// Observer operations that are reported to ObserverHook
+enum class observer_op {
+    Observe,
+    Unobserve,
+    Enable,
+    Disable
+};
+
+// Component that can be set on the Observable component to get notified of
+// observer operations. The entity is 0 for Enable and Disable.
+struct ObserverHook {
+    void *ctx;
+    void(*invoke)(world_t *world, entity_t e, entity_t observer, entity_t comp, 
+        observer_op op, void *ctx);
+};
+
 // Observer context data, responsible for reintroducing type safety
 template <typename T>
 class observer_mgr {
@@ -42,22 +64,25 @@ public:
         // Only start observing if the entity wasn't already being observed
         if (m_observables.insert(e.id()).second) {
             add_observable_trait(e);
+            invoke_hook(e.id(), observer_op::Observe);
         }
     }
 
     // Stop observing entity
     void remove_observable(flecs::entity e) {
-        if (!m_id) {
+        // Only stop observing if the entity was being observed
+        if (!m_id || !m_observables.erase(e.id())) {
             return;
         }
         remove_observable_trait(e);
-        m_observables.erase(e.id());
+        invoke_hook(e.id(), observer_op::Unobserve);
     }
 
     // Stop observing all observables
     void clear_observables() {
         for (auto e : m_observables) {
             remove_observable_trait(flecs::entity(m_world, e));
+            invoke_hook(e, observer_op::Unobserve);
         }
         m_observables.clear();
     }
@@ -68,6 +93,7 @@ public:
         for (auto e : m_observables) {
             add_observable_trait(flecs::entity(m_world, e));
         }
+        invoke_hook(0, observer_op::Enable);
     }
 
     // Disable observer
@@ -76,29 +102,73 @@ public:
         for (auto e : m_observables) {
             remove_observable_trait(flecs::entity(m_world, e));
         }
+        invoke_hook(0, observer_op::Disable);
     }
 
-    // Static function that can be stored in observer data
+    // Invoke observer. Also used by code that only has a type-erased pointer
+    // to the component value.
     static void invoke(flecs::entity e, void *ptr, void *ctx) {
         // Instance of self is stored in observer context
         observer_mgr<T> *self = static_cast<observer_mgr<T>*>(ctx);
         self->m_func(e, static_cast<T*>(ptr)[0]);
     }
+
+    // Register the system that invokes observers when T is set. A system is
+    // created once per component, the first time the component is observed.
+    // It only matches tables with the Observable trait for T, and reads T
+    // through a typed column.
+    static void register_dispatch(flecs::world& ecs) {
+        flecs::entity comp = ecs.component<T>();
+        if (comp.has<ObserverDispatch>()) {
+            return;
+        }
+
+        // The trait column provides the list of observers, the component
+        // column makes sure the system triggers when T is set.
+        std::string comp_path = comp.path(".", "");
+        std::string sig = "TRAIT | ";
+        sig += ecs.component<Observable>().path(".", "");
+        sig += " > " + comp_path + ", " + comp_path;
+
+        auto system = ecs.system<>(nullptr, sig.c_str())
+            .kind(flecs::OnSet)
+            .action([](flecs::iter it) {
+                // List of observers
+                auto observables = it.column<Observable>(1);
+
+                // The component data
+                auto data = it.column<T>(2);
+
+                // It is possible that multiple observable entities were updated
+                for (auto i : it) {
+                    // All observers of this trait are observers of T, so they
+                    // can be invoked directly.
+                    for (auto observer : observables[i].observers) {
+                        invoke(it.entity(i), &data[i], observer.second.ctx);
+                    }
+                }
+            });
+
+        comp.set<ObserverDispatch>({ system.id() });
+    }
 private:
     void add_observable_trait(flecs::entity e) {
         if (!m_id) {
             // Create a unique id for the observer, so we can store it in a 
             // map. Register the id with the invoker, so that the observer 
             // object can be moved around on the stack.
-            m_world = e.world().c_ptr();
+            flecs::world ecs = e.world();
+            m_world = ecs.c_ptr();
             m_id = ecs_new_id(m_world);
+
+            // Make sure there is a dispatch system for T
+            register_dispatch(ecs);
         }
 
         // Create the observer data that will be added to the list of observers
         // of the observable.
         observer_data data;
         data.ctx = this;
-        data.invoke = observer_mgr<T>::invoke;
         
         // Add the Observable trait for the type of the observer
         Observable *o = e.get_trait_mut<Observable, T>();
@@ -107,6 +177,22 @@ private:
         o->observers[m_id] = data;
     }
 
+    // Notify hook (if any) of an observer operation
+    void invoke_hook(entity_t e, observer_op op) {
+        // Nothing was observed yet, so there is nothing to report
+        if (!m_world) {
+            return;
+        }
+
+        flecs::world ecs(m_world);
+        const ObserverHook *hook = 
+            ecs.component<Observable>().get<ObserverHook>();
+        if (hook) {
+            hook->invoke(m_world, e, m_id, ecs.component<T>().id(), op, 
+                hook->ctx);
+        }
+    }
+
     void remove_observable_trait(flecs::entity e) {
         Observable *o = e.get_trait_mut<Observable, T>();
         o->observers.erase(m_id);
@@ -167,37 +253,21 @@ public:
     observable(flecs::world& ecs) {
         ecs.module<flecs::observable>();
 
-        // Register component so it can be accessed by name in signature
+        // Register components so they can be accessed by name in signature
         ecs.component<Observable>();
-
-        // Invoke observers when component is set.
-        // This system subscribes for the Observable trait which stores the list
-        // of observers, in addition to the component to which the trait is
-        // applied (the wildcard). The latter needs to be part of the signature
-        // or the system would not trigger when the component is set. 
+        ecs.component<ObserverDispatch>();
+        ecs.component<ObserverHook>();
+
+        // Observers are invoked by a system per observed component, which is
+        // registered by observer_mgr the first time a component is observed.
+        // Each system subscribes for the Observable trait for its component,
+        // in addition to the component itself. The latter needs to be part of
+        // the signature or the system would not trigger when the component is
+        // set.
         //
         // By using traits instead of a regular OnSet system we ensure that only
         // entities with the Observable trait trigger the system. Without the
         // trait, updates from any entity would trigger the system.
-        ecs.system<>("ObserverDispatch", "TRAIT | Observable, TRAIT | Observable > *")
-            .kind(flecs::OnSet)
-            .action([](flecs::iter it) {
-                // List of observers
-                auto observables = it.column<Observable>(1);
-
-                // The component data. Since we don't know the type of the 
-                // component at compile time, we need to use an untyped column.
-                auto data = it.column(2);
-
-                // It is possible that multiple observable entities were updated
-                for (auto i : it) {
-                    // Iterate observers, pass data to each one
-                    for (auto observer : observables[i].observers) {
-                        observer.second.invoke( 
-                                it.entity(i), data[i], observer.second.ctx ); 
-                    }
-                }
-            });
     }
 };
 
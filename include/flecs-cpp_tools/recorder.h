@@ -0,0 +1,486 @@
+#ifndef FLECS_RECORDER_H
+#define FLECS_RECORDER_H
+
+#include <flecs.h>
+#include <flecs-cpp_tools/observable.h>
+#include <flecs-cpp_tools/timers.h>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace flecs {
+
+// Record kinds in the log. Every record starts with one of these. Values are
+// written in native byte order, so a log can only be replayed on a platform
+// with the same endianness.
+namespace recording {
+    static const uint8_t Component = 'C';   // u32 index, u32 size, u32 len, name
+    static const uint8_t Observe = 'O';     // u64 observer, u64 entity, u32 index
+    static const uint8_t Unobserve = 'U';   // u64 observer, u64 entity, u32 index
+    static const uint8_t Enable = 'E';      // u64 observer, u32 index
+    static const uint8_t Disable = 'X';     // u64 observer, u32 index
+    static const uint8_t Set = 'S';         // u64 entity, u32 index, data
+    static const uint8_t AddTimer = 'A';    // u64 entity, u32 index, f32 timeout
+    static const uint8_t RemoveTimer = 'R'; // u64 entity, u32 index, f32 timeout
+    static const uint8_t DeleteTimer = 'D'; // u64 entity, f32 timeout
+    static const uint8_t Frame = 'F';       // f32 delta time, ends a frame
+
+    static const char Magic[4] = {'F', 'R', 'E', 'C'};
+    static const uint32_t Version = 2;
+}
+
+// Records the operations that drive the observable and timers modules into a
+// compact binary log, which can be replayed with flecs::replayer. Only the
+// components passed to record<T>() are captured.
+//
+// Operations are grouped per frame: a Frame record is written at the end of
+// each frame. The replayer applies the operations of a frame before running
+// it, so operations done by systems during a frame are replayed at the start
+// of that frame, before any system runs.
+class recorder {
+public:
+    recorder(flecs::world& ecs, std::ostream& out)
+        : m_world(ecs.c_ptr())
+        , m_out(out)
+    {
+        ecs.import<flecs::observable>();
+        ecs.import<flecs::timers>();
+
+        m_out.write(recording::Magic, sizeof(recording::Magic));
+        write(recording::Version);
+
+        // Get notified when observers start or stop observing entities. There
+        // is only one hook per world, so only one recorder can be active.
+        flecs::entity observable = ecs.component<Observable>();
+        ecs_assert(!observable.has<ObserverHook>(), ECS_INVALID_OPERATION,
+            "only one recorder can be active per world");
+        observable.set<ObserverHook>({ this, on_observe });
+
+        // Record the delta time at the end of each frame
+        m_systems.push_back(ecs.system<>()
+            .kind(flecs::PostFrame)
+            .action([this](flecs::iter it) {
+                write(recording::Frame);
+                write(static_cast<float>(it.delta_time()));
+            }).id());
+
+        std::string sig = ecs.component<DeleteTimer>().path(".", "");
+        m_systems.push_back(ecs.system<>(nullptr, sig.c_str())
+            .kind(flecs::OnSet)
+            .action([this](flecs::iter it) {
+                auto timer = it.column<DeleteTimer>(1);
+                for (auto i : it) {
+                    write(recording::DeleteTimer);
+                    write(static_cast<uint64_t>(it.entity(i).id()));
+                    write(timer[i].timeout);
+                }
+            }).id());
+    }
+
+    ~recorder() {
+        // Only remove the hook if it is the one set by this recorder
+        flecs::world ecs(m_world);
+        flecs::entity observable = ecs.component<Observable>();
+        const ObserverHook *hook = observable.get<ObserverHook>();
+        if (hook && hook->ctx == this) {
+            observable.remove<ObserverHook>();
+        }
+
+        for (auto s : m_systems) {
+            ecs_delete(m_world, s);
+        }
+
+        m_out.flush();
+    }
+
+    // Systems and the observer hook hold a pointer to the recorder
+    recorder(const recorder&) = delete;
+    recorder& operator=(const recorder&) = delete;
+
+    // Start recording operations for a component
+    template <typename T>
+    recorder& record() {
+        // Values are written as raw bytes, which for other types would store
+        // pointers that are not valid in the replaying process.
+        static_assert(std::is_trivially_copyable<T>::value, 
+            "recorded component must be trivially copyable");
+
+        flecs::world ecs(m_world);
+        flecs::entity comp = ecs.component<T>();
+        if (m_components.find(comp.id()) != m_components.end()) {
+            return *this;
+        }
+
+        uint32_t index = static_cast<uint32_t>(m_components.size());
+        m_components[comp.id()] = index;
+
+        std::string comp_path = comp.path(".", "");
+        write(recording::Component);
+        write(index);
+        write(static_cast<uint32_t>(sizeof(T)));
+        write(static_cast<uint32_t>(comp_path.size()));
+        m_out.write(comp_path.c_str(), comp_path.size());
+
+        // Component sets on observed entities
+        std::string sig = "TRAIT | ";
+        sig += ecs.component<Observable>().path(".", "");
+        sig += " > " + comp_path + ", " + comp_path;
+        m_systems.push_back(ecs.system<>(nullptr, sig.c_str())
+            .kind(flecs::OnSet)
+            .action([this, index](flecs::iter it) {
+                auto data = it.column<T>(2);
+                for (auto i : it) {
+                    write(recording::Set);
+                    write(static_cast<uint64_t>(it.entity(i).id()));
+                    write(index);
+                    m_out.write(
+                        reinterpret_cast<const char*>(&data[i]), sizeof(T));
+                }
+            }).id());
+
+        // Timer creation
+        record_timer<AddTimer>(ecs, comp_path, index, recording::AddTimer);
+        record_timer<RemoveTimer>(ecs, comp_path, index, recording::RemoveTimer);
+
+        return *this;
+    }
+
+private:
+    template <typename V>
+    void write(const V& value) {
+        m_out.write(reinterpret_cast<const char*>(&value), sizeof(V));
+    }
+
+    template <typename Timer>
+    void record_timer(flecs::world& ecs, const std::string& comp_path,
+        uint32_t index, uint8_t kind)
+    {
+        std::string sig = "TRAIT | ";
+        sig += ecs.component<Timer>().path(".", "");
+        sig += " > " + comp_path;
+        m_systems.push_back(ecs.system<>(nullptr, sig.c_str())
+            .kind(flecs::OnSet)
+            .action([this, index, kind](flecs::iter it) {
+                auto timer = it.column<Timer>(1);
+                for (auto i : it) {
+                    write(kind);
+                    write(static_cast<uint64_t>(it.entity(i).id()));
+                    write(index);
+                    write(timer[i].timeout);
+                }
+            }).id());
+    }
+
+    static void on_observe(world_t *world, entity_t e, entity_t observer, 
+        entity_t comp, observer_op op, void *ctx)
+    {
+        recorder *self = static_cast<recorder*>(ctx);
+        auto it = self->m_components.find(comp);
+        if (it == self->m_components.end()) {
+            return;
+        }
+
+        switch(op) {
+        case observer_op::Observe:
+        case observer_op::Unobserve:
+            self->write(op == observer_op::Observe 
+                ? recording::Observe : recording::Unobserve);
+            self->write(static_cast<uint64_t>(observer));
+            self->write(static_cast<uint64_t>(e));
+            self->write(it->second);
+            break;
+        case observer_op::Enable:
+        case observer_op::Disable:
+            self->write(op == observer_op::Enable 
+                ? recording::Enable : recording::Disable);
+            self->write(static_cast<uint64_t>(observer));
+            self->write(it->second);
+            break;
+        }
+    }
+
+    world_t *m_world;
+    std::ostream& m_out;
+    std::unordered_map<entity_t, uint32_t> m_components;
+    std::vector<entity_t> m_systems;
+};
+
+// Interface for applying recorded operations to a component in a fresh world.
+// Implemented for each component registered with the replayer.
+class replay_component_base {
+public:
+    virtual ~replay_component_base() { }
+    virtual size_t size() const = 0;
+    virtual void set(flecs::entity e, const void *data) = 0;
+    virtual void observe(entity_t observer, flecs::entity e) = 0;
+    virtual void unobserve(entity_t observer, flecs::entity e) = 0;
+    virtual void enable(entity_t observer, bool enabled) = 0;
+    virtual void add_timer(flecs::entity e, float timeout) = 0;
+    virtual void remove_timer(flecs::entity e, float timeout) = 0;
+};
+
+template <typename T>
+class replay_component final : public replay_component_base {
+public:
+    replay_component(const observer_func<T>& func)
+        : m_func(func) { }
+
+    ~replay_component() {
+        for (auto o : m_observers) {
+            delete o.second;
+        }
+    }
+
+    size_t size() const override {
+        return sizeof(T);
+    }
+
+    void set(flecs::entity e, const void *data) override {
+        e.set<T>(*static_cast<const T*>(data));
+    }
+
+    // Each recorded observer is replayed by its own observer instance
+    void observe(entity_t observer_id, flecs::entity e) override {
+        observer<T> *&o = m_observers[observer_id];
+        if (!o) {
+            o = new observer<T>(m_func);
+        }
+        o->observe(e);
+    }
+
+    void unobserve(entity_t observer_id, flecs::entity e) override {
+        auto it = m_observers.find(observer_id);
+        if (it != m_observers.end()) {
+            it->second->unobserve(e);
+        }
+    }
+
+    void enable(entity_t observer_id, bool enabled) override {
+        auto it = m_observers.find(observer_id);
+        if (it != m_observers.end()) {
+            if (enabled) {
+                it->second->enable();
+            } else {
+                it->second->disable();
+            }
+        }
+    }
+
+    void add_timer(flecs::entity e, float timeout) override {
+        e.set_trait<AddTimer, T>({timeout});
+    }
+
+    void remove_timer(flecs::entity e, float timeout) override {
+        e.set_trait<RemoveTimer, T>({timeout});
+    }
+
+private:
+    observer_func<T> m_func;
+    std::unordered_map<entity_t, observer<T>*> m_observers;
+};
+
+// Drives a world from a log created by flecs::recorder, as fast as possible.
+// Components in the log are matched by path with the components registered
+// with component<T>(). Operations on unregistered components are skipped.
+class replayer {
+public:
+    replayer(flecs::world& ecs)
+        : m_world(ecs.c_ptr())
+    {
+        ecs.import<flecs::observable>();
+        ecs.import<flecs::timers>();
+    }
+
+    ~replayer() {
+        for (auto c : m_registered) {
+            delete c.second;
+        }
+    }
+
+    replayer(const replayer&) = delete;
+    replayer& operator=(const replayer&) = delete;
+
+    // Register a component that can be replayed. Replayed observers invoke
+    // the provided function.
+    template <typename T>
+    replayer& component(observer_func<T> func = [](flecs::entity, const T&) { }) {
+        static_assert(std::is_trivially_copyable<T>::value, 
+            "replayed component must be trivially copyable");
+
+        flecs::world ecs(m_world);
+        std::string path = ecs.component<T>().path(".", "");
+        replay_component_base *&c = m_registered[path];
+        if (!c) {
+            c = new replay_component<T>(func);
+        }
+        return *this;
+    }
+
+    // Replay log. Returns the number of replayed frames, or -1 if the log is
+    // not a valid recording.
+    int32_t run(std::istream& in) {
+        flecs::world ecs(m_world);
+
+        char magic[sizeof(recording::Magic)];
+        uint32_t version = 0;
+        in.read(magic, sizeof(magic));
+        read(in, version);
+        if (!in || std::string(magic, sizeof(magic)) !=
+            std::string(recording::Magic, sizeof(recording::Magic)) ||
+            version != recording::Version)
+        {
+            return -1;
+        }
+
+        std::vector<char> buffer;
+        int32_t frames = 0;
+        uint8_t kind;
+
+        while (read(in, kind)) {
+            uint64_t observer = 0, e = 0;
+            uint32_t index = 0;
+            float value = 0;
+
+            switch(kind) {
+            case recording::Component: {
+                uint32_t size = 0, len = 0;
+                read(in, index);
+                read(in, size);
+                read(in, len);
+                std::string path(len, '\0');
+                in.read(&path[0], len);
+
+                replay_component_base *c = nullptr;
+                auto it = m_registered.find(path);
+                if (it != m_registered.end() && it->second->size() == size) {
+                    c = it->second;
+                }
+
+                if (m_components.size() <= index) {
+                    m_components.resize(index + 1);
+                }
+                m_components[index] = { c, size };
+                break;
+            }
+            case recording::Observe:
+            case recording::Unobserve:
+                read(in, observer);
+                read(in, e);
+                read(in, index);
+                if (replay_component_base *c = get_component(index)) {
+                    if (kind == recording::Observe) {
+                        c->observe(observer, entity(e));
+                    } else {
+                        c->unobserve(observer, entity(e));
+                    }
+                }
+                break;
+            case recording::Enable:
+            case recording::Disable:
+                read(in, observer);
+                read(in, index);
+                if (replay_component_base *c = get_component(index)) {
+                    c->enable(observer, kind == recording::Enable);
+                }
+                break;
+            case recording::Set:
+                read(in, e);
+                read(in, index);
+                if (index >= m_components.size()) {
+                    return -1;
+                }
+                buffer.resize(m_components[index].size);
+                in.read(buffer.data(), buffer.size());
+                if (replay_component_base *c = get_component(index)) {
+                    c->set(entity(e), buffer.data());
+                }
+                break;
+            case recording::AddTimer:
+            case recording::RemoveTimer:
+                read(in, e);
+                read(in, index);
+                read(in, value);
+                if (replay_component_base *c = get_component(index)) {
+                    if (kind == recording::AddTimer) {
+                        c->add_timer(entity(e), value);
+                    } else {
+                        c->remove_timer(entity(e), value);
+                    }
+                }
+                break;
+            case recording::DeleteTimer:
+                read(in, e);
+                read(in, value);
+                entity(e).set<DeleteTimer>({value});
+                break;
+            case recording::Frame:
+                read(in, value);
+                progress(ecs, value);
+                frames ++;
+                break;
+            default:
+                return -1;
+            }
+
+            if (!in) {
+                return -1;
+            }
+        }
+
+        return frames;
+    }
+
+private:
+    struct log_component {
+        replay_component_base *component;
+        uint32_t size;
+    };
+
+    template <typename V>
+    static bool read(std::istream& in, V& value) {
+        return static_cast<bool>(
+            in.read(reinterpret_cast<char*>(&value), sizeof(V)));
+    }
+
+    // Run a frame with a recorded delta time. progress(0) measures the delta
+    // time instead of using it, so frames with a zero delta time are run with
+    // a time scale of 0. The replayed world always runs with a time scale of 1.
+    static void progress(flecs::world& ecs, float delta_time) {
+        if (delta_time != 0) {
+            ecs.progress(delta_time);
+        } else {
+            ecs_set_time_scale(ecs.c_ptr(), 0);
+            ecs.progress(1);
+            ecs_set_time_scale(ecs.c_ptr(), 1);
+        }
+    }
+
+    replay_component_base* get_component(uint32_t index) {
+        if (index >= m_components.size()) {
+            return nullptr;
+        }
+        return m_components[index].component;
+    }
+
+    // Map entity from the recorded world to an entity in the replayed world
+    flecs::entity entity(uint64_t id) {
+        entity_t &e = m_entities[id];
+        if (!e) {
+            e = ecs_new_id(m_world);
+        }
+        return flecs::entity(m_world, e);
+    }
+
+    world_t *m_world;
+    std::unordered_map<std::string, replay_component_base*> m_registered;
+    std::vector<log_component> m_components;
+    std::unordered_map<uint64_t, entity_t> m_entities;
+};
+
+}
+
+#endif
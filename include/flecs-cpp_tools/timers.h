@@ -2,6 +2,26 @@
 #define FLECS_TIMERS_H
 
 #include <flecs.h>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FLECS_TIMERS_SSE
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define FLECS_TIMERS_AVX2
+#define FLECS_TIMERS_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define FLECS_TIMERS_AVX2
+#define FLECS_TIMERS_AVX2_TARGET
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace flecs {
 
@@ -43,48 +63,197 @@ public:
                 flecs::entity trait = it.column_entity(1);
                 flecs::entity comp = trait.lo(); // Component id
 
-                for (auto i : it) {
-                    // Increase timer. When it equals timeout, add component
-                    timer[i].t += it.delta_time();
-                    if (timer[i].t >= timer[i].timeout) {
-                        // Remove trait so that it won't keep triggering for
-                        // this entity.
-                        it.entity(i).remove(trait);               
-                        it.entity(i).add(comp); // Add the component
-                    }
-                }
+                // Increase timers. Only visit timers that reached timeout
+                scan(it, timer, [&](int32_t i) {
+                    // Remove trait so that it won't keep triggering for
+                    // this entity.
+                    it.entity(i).remove(trait);               
+                    it.entity(i).add(comp); // Add the component
+                });
             });
 
         ecs.system<>(nullptr, "TRAIT | RemoveTimer")
             .action([](flecs::iter it) {
                 // Get the timer component
-                auto timer = it.column<AddTimer>(1);
+                auto timer = it.column<RemoveTimer>(1);
 
                 // Get the handle to the trait. This contains information about
                 // the component the trait is applied to.
                 flecs::entity trait = it.column_entity(1);
                 flecs::entity comp = trait.lo(); // Component id
 
-                for (auto i : it) {
-                    // Increase timer. When it equals timeout, remove component
-                    timer[i].t += it.delta_time();
-                    if (timer[i].t >= timer[i].timeout) {
-                        // Remove trait so that it won't keep triggering for
-                        // this entity.
-                        it.entity(i).remove(trait);               
-                        it.entity(i).remove(comp); // Remove the component
-                    }
-                }
+                // Increase timers. Only visit timers that reached timeout
+                scan(it, timer, [&](int32_t i) {
+                    // Remove trait so that it won't keep triggering for
+                    // this entity.
+                    it.entity(i).remove(trait);               
+                    it.entity(i).remove(comp); // Remove the component
+                });
             });   
 
         ecs.system<DeleteTimer>()
-            .each([](flecs::entity e, DeleteTimer& timer) {
-                timer.t += e.delta_time();
-                if (timer.t >= timer.timeout) {            
-                    e.destruct(); // Delete entity
-                }
+            .action([](flecs::iter it, flecs::column<DeleteTimer> timer) {
+                scan(it, timer, [&](int32_t i) {
+                    it.entity(i).destruct(); // Delete entity
+                });
             });             
     }
+
+    // Advance an array of timers in blocks of 64, then invoke func for the
+    // index of each expired timer. Structural changes are only made for
+    // expired timers, which keeps them out of the loop that does the math.
+    template <typename Timer, typename Func>
+    static void scan(Timer *timers, int32_t count, float dt, const Func& func) {
+        static_assert(sizeof(Timer) == 2 * sizeof(float), 
+            "timer must consist of timeout and t");
+        static_assert(offsetof(Timer, timeout) == 0, 
+            "timeout must be first member of timer");
+        static_assert(offsetof(Timer, t) == sizeof(float), 
+            "t must be second member of timer");
+
+        static const kernel_t kernel = select_kernel();
+
+        float *data = reinterpret_cast<float*>(timers);
+        for (int32_t i = 0; i < count; i += 64) {
+            int32_t n = count - i < 64 ? count - i : 64;
+            uint64_t mask = kernel(&data[i * 2], n, dt);
+            while (mask) {
+                func(i + lowest_bit(mask));
+                mask &= mask - 1;
+            }
+        }
+    }
+
+private:
+    // Kernel that adds delta time to count (at most 64) timers, and returns a
+    // bitmask with a bit set for each timer that reached its timeout. Timers
+    // are passed as interleaved (timeout, t) pairs.
+    using kernel_t = uint64_t(*)(float *timers, int32_t count, float dt);
+
+    // Advance the timers of the iterated table. Only owned timers are
+    // advanced. A shared timer (for example one inherited from a prefab) is a
+    // single value for all instances. It would be advanced once for each
+    // table that inherits it, and instances can't remove the trait when it
+    // expires, so the action would run every frame. Shared timers are
+    // therefore ignored.
+    template <typename Timer, typename Func>
+    static void scan(flecs::iter& it, flecs::column<Timer>& timer, 
+        const Func& func) 
+    {
+        if (it.is_shared(1)) {
+            return;
+        }
+
+        scan(&timer[0], it.count(), it.delta_time(), func);
+    }
+
+    static kernel_t select_kernel() {
+#if defined(FLECS_TIMERS_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+        if (__builtin_cpu_supports("avx2")) {
+            return advance_avx2;
+        }
+#else
+        return advance_avx2;
+#endif
+#endif
+#if defined(FLECS_TIMERS_SSE)
+        return advance_sse;
+#else
+        return advance_scalar;
+#endif
+    }
+
+    static int32_t lowest_bit(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<int32_t>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(mask);
+#else
+        int32_t index = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            index ++;
+        }
+        return index;
+#endif
+    }
+
+    static uint64_t advance_scalar(float *timers, int32_t count, float dt) {
+        uint64_t mask = 0;
+        for (int32_t i = 0; i < count; i ++) {
+            float t = timers[i * 2 + 1] += dt;
+            mask |= static_cast<uint64_t>(t >= timers[i * 2]) << i;
+        }
+        return mask;
+    }
+
+#if defined(FLECS_TIMERS_SSE)
+    // Processes 4 timers per iteration
+    static uint64_t advance_sse(float *timers, int32_t count, float dt) {
+        // Only add delta time to the t lanes
+        const __m128 delta = _mm_set_ps(dt, 0, dt, 0);
+        uint64_t mask = 0;
+        int32_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 v0 = _mm_add_ps(_mm_loadu_ps(&timers[i * 2]), delta);
+            __m128 v1 = _mm_add_ps(_mm_loadu_ps(&timers[i * 2 + 4]), delta);
+            _mm_storeu_ps(&timers[i * 2], v0);
+            _mm_storeu_ps(&timers[i * 2 + 4], v1);
+
+            // Deinterleave into timeout and t lanes, then compare
+            __m128 timeout = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 t = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+            uint64_t bits = static_cast<uint64_t>(
+                _mm_movemask_ps(_mm_cmpge_ps(t, timeout)));
+            mask |= bits << i;
+        }
+
+        if (i < count) {
+            mask |= advance_scalar(&timers[i * 2], count - i, dt) << i;
+        }
+
+        return mask;
+    }
+#endif
+
+#if defined(FLECS_TIMERS_AVX2)
+    // Processes 8 timers per iteration
+    FLECS_TIMERS_AVX2_TARGET
+    static uint64_t advance_avx2(float *timers, int32_t count, float dt) {
+        // Only add delta time to the t lanes
+        const __m256 delta = _mm256_set_ps(dt, 0, dt, 0, dt, 0, dt, 0);
+        uint64_t mask = 0;
+        int32_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            __m256 v0 = _mm256_add_ps(_mm256_loadu_ps(&timers[i * 2]), delta);
+            __m256 v1 = _mm256_add_ps(_mm256_loadu_ps(&timers[i * 2 + 8]), delta);
+            _mm256_storeu_ps(&timers[i * 2], v0);
+            _mm256_storeu_ps(&timers[i * 2 + 8], v1);
+
+            // Deinterleave into timeout and t lanes, then compare. Shuffles
+            // stay within 128 bit lanes, so results are in timer order 
+            // 0 1 4 5 2 3 6 7, which the permute puts back in order.
+            __m256 timeout = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 t = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+            __m256d cmp = _mm256_castps_pd(_mm256_cmp_ps(t, timeout, _CMP_GE_OQ));
+            cmp = _mm256_permute4x64_pd(cmp, _MM_SHUFFLE(3, 1, 2, 0));
+            uint64_t bits = static_cast<uint64_t>(
+                _mm256_movemask_ps(_mm256_castpd_ps(cmp)));
+            mask |= bits << i;
+        }
+
+        if (i < count) {
+            mask |= advance_scalar(&timers[i * 2], count - i, dt) << i;
+        }
+
+        return mask;
+    }
+#endif
 };
 
 }
@@ -6,6 +6,7 @@
 #include "flecs-cpp_tools/observable.h"
 #include "flecs-cpp_tools/timers.h"
 #include "flecs-cpp_tools/dump.h"
+#include "flecs-cpp_tools/recorder.h"
 
 #endif
 